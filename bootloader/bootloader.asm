@@ -1,61 +1,131 @@
 ; CrusadeOS BIOS Bootloader
-; Simple 512-byte MBR bootloader that loads the kernel
+; Simple 512-byte MBR bootloader that loads the kernel and enters long mode
 
 [BITS 16]
 [ORG 0x7C00]
 
+; Kernel layout (must match kernel/kernel.ld and the Makefile)
+%ifndef KERNEL_SECTORS
+KERNEL_SECTORS equ 64           ; Sectors read after the MBR (32KB)
+%endif
+KERNEL_STAGE_SEG equ 0x1000     ; BIOS reads the kernel to 0x10000 first
+KERNEL_STAGE equ 0x10000
+KERNEL_BASE equ 0x100000        ; Kernel link address - 1MB
+
+; Identity-mapped page tables (first 1GB with 2MB pages)
+PML4_ADDR equ 0x1000
+PDPT_ADDR equ 0x2000
+PD_ADDR equ 0x3000
+
 start:
+    ; Normalize CS:IP to 0000:7C00
+    jmp 0x0000:init
+
+init:
     ; Set up segments
     xor ax, ax
     mov ds, ax
     mov es, ax
     mov ss, ax
     mov sp, 0x7C00
-    
+    mov [boot_drive], dl
+
     ; Print boot message
     mov si, boot_msg
     call print_string
-    
+
     ; Load kernel from disk
-    ; Read 10 sectors starting at sector 1 (after MBR)
+    ; Read KERNEL_SECTORS starting at LBA 1 (after MBR) in one request
     mov si, load_msg
     call print_string
-    
-    mov ah, 0x02        ; Read sectors function
-    mov al, 10          ; Number of sectors to read
-    mov ch, 0           ; Cylinder 0
-    mov cl, 2           ; Start from sector 2 (sector 1 is MBR)
-    mov dh, 0           ; Head 0
-    mov dl, 0x80        ; Drive 0 (first hard disk)
-    mov bx, 0x1000      ; Load kernel at 0x1000
+
+    mov si, disk_packet
+    mov ah, 0x42        ; Extended read sectors function
+    mov dl, [boot_drive]
     int 0x13            ; BIOS disk interrupt
-    
+
     jc disk_error       ; Jump if carry flag set (error)
-    
+
+    ; Make sure the CPU supports long mode
+    mov eax, 0x80000000
+    cpuid
+    cmp eax, 0x80000001
+    jb no_long_mode
+    mov eax, 0x80000001
+    cpuid
+    test edx, 1 << 29   ; LM bit
+    jz no_long_mode
+
     ; Print success message
     mov si, success_msg
     call print_string
-    
-    ; Set up protected mode
+
+    ; Enable A20 line (fast A20 gate)
+    in al, 0x92
+    or al, 2
+    and al, 0xFE
+    out 0x92, al
+
+    ; Clear page table area
+    mov di, PML4_ADDR
+    mov cx, (PD_ADDR + 0x1000 - PML4_ADDR) / 2
+    xor ax, ax
+    rep stosw
+
+    ; PML4[0] -> PDPT, PDPT[0] -> PD (present, writable)
+    mov word [PML4_ADDR], PDPT_ADDR | 0x03
+    mov word [PDPT_ADDR], PD_ADDR | 0x03
+
+    ; PD: 512 x 2MB pages identity-mapping the first 1GB
+    mov di, PD_ADDR
+    mov eax, 0x83       ; Present, writable, page size
+.map_pd:
+    mov [di], eax
+    add eax, 0x200000
+    add di, 8
+    cmp di, PD_ADDR + 0x1000
+    jb .map_pd
+
+    ; Set up long mode
     cli                 ; Disable interrupts
-    
+
     ; Load GDT
     lgdt [gdt_descriptor]
-    
-    ; Enable protected mode
+
+    ; Enable PAE and SSE (OSFXSR, OSXMMEXCPT)
+    mov eax, 0x620
+    mov cr4, eax
+
+    ; Point CR3 at the PML4
+    mov eax, PML4_ADDR
+    mov cr3, eax
+
+    ; Set EFER.LME
+    mov ecx, 0xC0000080
+    rdmsr
+    or eax, 1 << 8
+    wrmsr
+
+    ; Enable paging and protected mode, FPU/SSE on (clear EM, set MP)
     mov eax, cr0
-    or eax, 1
+    and eax, ~(1 << 2)
+    or eax, 0x80000003
     mov cr0, eax
-    
-    ; Jump to 32-bit code
-    jmp 0x08:protected_mode
+
+    ; Jump to 64-bit code
+    jmp 0x08:long_mode
+
+no_long_mode:
+    mov si, cpu_error_msg
+    jmp halt_with_message
 
 disk_error:
     mov si, error_msg
+
+halt_with_message:
     call print_string
     mov si, retry_msg
     call print_string
-    jmp hang
 
 hang:
     hlt
@@ -72,53 +142,60 @@ print_string:
 .done:
     ret
 
-[BITS 32]
-protected_mode:
-    ; Set up 32-bit segments
+[BITS 64]
+long_mode:
+    ; Set up 64-bit data segments
     mov ax, 0x10        ; Data segment selector
     mov ds, ax
     mov es, ax
     mov fs, ax
     mov gs, ax
     mov ss, ax
-    mov esp, 0x90000    ; Set up stack
-    
-    ; Print 32-bit message (simple VGA text mode)
-    mov edi, 0xB8000    ; VGA text buffer
-    mov esi, pmode_msg
-    mov ah, 0x0F        ; White on black
-.print_loop:
-    lodsb
-    test al, al
-    jz .done
-    stosw               ; Store AL (char) and AH (attribute)
-    jmp .print_loop
-.done:
-    
-    ; Jump to kernel
-    jmp 0x1000
+    mov rsp, 0x90000    ; Set up stack
+
+    ; Copy kernel to its link address
+    mov esi, KERNEL_STAGE
+    mov edi, KERNEL_BASE
+    mov ecx, KERNEL_SECTORS * 512 / 8
+    rep movsq
+
+    ; Jump to kernel (no BOOT_INFO on BIOS boot)
+    xor edi, edi
+    mov eax, KERNEL_BASE
+    jmp rax
 
 ; Messages
 boot_msg db 'CrusadeOS BIOS Bootloader', 13, 10, 0
 load_msg db 'Loading kernel...', 13, 10, 0
-success_msg db 'Kernel loaded! Entering protected mode...', 13, 10, 0
+success_msg db 'Entering long mode...', 13, 10, 0
 error_msg db 'Disk read error!', 13, 10, 0
+cpu_error_msg db 'No 64-bit CPU!', 13, 10, 0
 retry_msg db 'System halted.', 13, 10, 0
-pmode_msg db 'Protected Mode - Starting Kernel...', 0
+
+boot_drive db 0
+
+; Disk address packet for INT 13h AH=42h
+disk_packet:
+    db 0x10             ; Packet size
+    db 0                ; Reserved
+    dw KERNEL_SECTORS   ; Sectors to read
+    dw 0x0000           ; Buffer offset
+    dw KERNEL_STAGE_SEG ; Buffer segment
+    dq 1                ; Starting LBA
 
 ; GDT (Global Descriptor Table)
 gdt_start:
     ; Null descriptor
     dq 0
-    
+
     ; Code segment descriptor
     dw 0xFFFF           ; Limit low
     dw 0x0000           ; Base low
     db 0x00             ; Base middle
     db 0x9A             ; Access byte (code, readable, executable)
-    db 0xCF             ; Flags + limit high
+    db 0xAF             ; Flags (long mode) + limit high
     db 0x00             ; Base high
-    
+
     ; Data segment descriptor
     dw 0xFFFF           ; Limit low
     dw 0x0000           ; Base low
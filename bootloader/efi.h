@@ -0,0 +1,340 @@
+/*
+ * CrusadeOS UEFI Definitions
+ *
+ * Minimal subset of the UEFI specification used by the UEFI loader.
+ * Base types and BOOT_INFO come from the kernel header so both sides
+ * of the handoff share one definition.
+ */
+
+#ifndef EFI_H
+#define EFI_H
+
+#include "../kernel/kernel.h"
+
+// Calling convention for firmware services
+#define EFIAPI __attribute__((ms_abi))
+
+typedef VOID   *EFI_HANDLE;
+typedef VOID   *EFI_EVENT;
+typedef UINT64 EFI_PHYSICAL_ADDRESS;
+typedef UINT64 EFI_VIRTUAL_ADDRESS;
+
+// Status codes
+#define EFI_ERROR_BIT           0x8000000000000000ULL
+#define EFI_ERROR(Status)       (((INTN)(Status)) < 0)
+#define EFI_LOAD_ERROR          (EFI_ERROR_BIT | 1)
+#define EFI_INVALID_PARAMETER   (EFI_ERROR_BIT | 2)
+#define EFI_UNSUPPORTED         (EFI_ERROR_BIT | 3)
+#define EFI_BUFFER_TOO_SMALL    (EFI_ERROR_BIT | 5)
+#define EFI_NOT_FOUND           (EFI_ERROR_BIT | 14)
+
+typedef struct {
+    UINT32 Data1;
+    UINT16 Data2;
+    UINT16 Data3;
+    UINT8  Data4[8];
+} EFI_GUID;
+
+typedef struct {
+    UINT64 Signature;
+    UINT32 Revision;
+    UINT32 HeaderSize;
+    UINT32 CRC32;
+    UINT32 Reserved;
+} EFI_TABLE_HEADER;
+
+// Memory allocation
+typedef enum {
+    AllocateAnyPages,
+    AllocateMaxAddress,
+    AllocateAddress,
+    MaxAllocateType
+} EFI_ALLOCATE_TYPE;
+
+typedef enum {
+    EfiReservedMemoryType,
+    EfiLoaderCode,
+    EfiLoaderData,
+    EfiBootServicesCode,
+    EfiBootServicesData,
+    EfiRuntimeServicesCode,
+    EfiRuntimeServicesData,
+    EfiConventionalMemory,
+    EfiUnusableMemory,
+    EfiACPIReclaimMemory,
+    EfiACPIMemoryNVS,
+    EfiMemoryMappedIO,
+    EfiMemoryMappedIOPortSpace,
+    EfiPalCode,
+    EfiPersistentMemory,
+    EfiMaxMemoryType
+} EFI_MEMORY_TYPE;
+
+typedef struct {
+    UINT32               Type;
+    EFI_PHYSICAL_ADDRESS PhysicalStart;
+    EFI_VIRTUAL_ADDRESS  VirtualStart;
+    UINT64               NumberOfPages;
+    UINT64               Attribute;
+} EFI_MEMORY_DESCRIPTOR;
+
+#define EFI_PAGE_SIZE 4096
+
+// Simple text output (only OutputString is used)
+struct _EFI_SIMPLE_TEXT_OUTPUT_PROTOCOL;
+
+typedef EFI_STATUS (EFIAPI *EFI_TEXT_STRING)(
+    struct _EFI_SIMPLE_TEXT_OUTPUT_PROTOCOL *This, CHAR16 *String);
+
+typedef struct _EFI_SIMPLE_TEXT_OUTPUT_PROTOCOL {
+    VOID            *Reset;
+    EFI_TEXT_STRING OutputString;
+    VOID            *TestString;
+    VOID            *QueryMode;
+    VOID            *SetMode;
+    VOID            *SetAttribute;
+    VOID            *ClearScreen;
+    VOID            *SetCursorPosition;
+    VOID            *EnableCursor;
+    VOID            *Mode;
+} EFI_SIMPLE_TEXT_OUTPUT_PROTOCOL;
+
+// Boot services
+typedef EFI_STATUS (EFIAPI *EFI_ALLOCATE_PAGES)(
+    EFI_ALLOCATE_TYPE Type, EFI_MEMORY_TYPE MemoryType, UINTN Pages, EFI_PHYSICAL_ADDRESS *Memory);
+typedef EFI_STATUS (EFIAPI *EFI_FREE_PAGES)(
+    EFI_PHYSICAL_ADDRESS Memory, UINTN Pages);
+typedef EFI_STATUS (EFIAPI *EFI_GET_MEMORY_MAP)(
+    UINTN *MemoryMapSize, EFI_MEMORY_DESCRIPTOR *MemoryMap, UINTN *MapKey,
+    UINTN *DescriptorSize, UINT32 *DescriptorVersion);
+typedef EFI_STATUS (EFIAPI *EFI_ALLOCATE_POOL)(
+    EFI_MEMORY_TYPE PoolType, UINTN Size, VOID **Buffer);
+typedef EFI_STATUS (EFIAPI *EFI_FREE_POOL)(VOID *Buffer);
+typedef EFI_STATUS (EFIAPI *EFI_HANDLE_PROTOCOL)(
+    EFI_HANDLE Handle, EFI_GUID *Protocol, VOID **Interface);
+typedef EFI_STATUS (EFIAPI *EFI_EXIT_BOOT_SERVICES)(
+    EFI_HANDLE ImageHandle, UINTN MapKey);
+typedef EFI_STATUS (EFIAPI *EFI_SET_WATCHDOG_TIMER)(
+    UINTN Timeout, UINT64 WatchdogCode, UINTN DataSize, CHAR16 *WatchdogData);
+typedef EFI_STATUS (EFIAPI *EFI_LOCATE_PROTOCOL)(
+    EFI_GUID *Protocol, VOID *Registration, VOID **Interface);
+
+typedef struct {
+    EFI_TABLE_HEADER       Hdr;
+
+    // Task priority services
+    VOID                   *RaiseTPL;
+    VOID                   *RestoreTPL;
+
+    // Memory services
+    EFI_ALLOCATE_PAGES     AllocatePages;
+    EFI_FREE_PAGES         FreePages;
+    EFI_GET_MEMORY_MAP     GetMemoryMap;
+    EFI_ALLOCATE_POOL      AllocatePool;
+    EFI_FREE_POOL          FreePool;
+
+    // Event and timer services
+    VOID                   *CreateEvent;
+    VOID                   *SetTimer;
+    VOID                   *WaitForEvent;
+    VOID                   *SignalEvent;
+    VOID                   *CloseEvent;
+    VOID                   *CheckEvent;
+
+    // Protocol handler services
+    VOID                   *InstallProtocolInterface;
+    VOID                   *ReinstallProtocolInterface;
+    VOID                   *UninstallProtocolInterface;
+    EFI_HANDLE_PROTOCOL    HandleProtocol;
+    VOID                   *Reserved;
+    VOID                   *RegisterProtocolNotify;
+    VOID                   *LocateHandle;
+    VOID                   *LocateDevicePath;
+    VOID                   *InstallConfigurationTable;
+
+    // Image services
+    VOID                   *LoadImage;
+    VOID                   *StartImage;
+    VOID                   *Exit;
+    VOID                   *UnloadImage;
+    EFI_EXIT_BOOT_SERVICES ExitBootServices;
+
+    // Miscellaneous services
+    VOID                   *GetNextMonotonicCount;
+    VOID                   *Stall;
+    EFI_SET_WATCHDOG_TIMER SetWatchdogTimer;
+
+    // Driver support services
+    VOID                   *ConnectController;
+    VOID                   *DisconnectController;
+
+    // Open and close protocol services
+    VOID                   *OpenProtocol;
+    VOID                   *CloseProtocol;
+    VOID                   *OpenProtocolInformation;
+
+    // Library services
+    VOID                   *ProtocolsPerHandle;
+    VOID                   *LocateHandleBuffer;
+    EFI_LOCATE_PROTOCOL    LocateProtocol;
+    VOID                   *InstallMultipleProtocolInterfaces;
+    VOID                   *UninstallMultipleProtocolInterfaces;
+
+    // CRC and memory services
+    VOID                   *CalculateCrc32;
+    VOID                   *CopyMem;
+    VOID                   *SetMem;
+    VOID                   *CreateEventEx;
+} EFI_BOOT_SERVICES;
+
+typedef struct {
+    EFI_TABLE_HEADER                Hdr;
+    CHAR16                          *FirmwareVendor;
+    UINT32                          FirmwareRevision;
+    EFI_HANDLE                      ConsoleInHandle;
+    VOID                            *ConIn;
+    EFI_HANDLE                      ConsoleOutHandle;
+    EFI_SIMPLE_TEXT_OUTPUT_PROTOCOL *ConOut;
+    EFI_HANDLE                      StandardErrorHandle;
+    EFI_SIMPLE_TEXT_OUTPUT_PROTOCOL *StdErr;
+    VOID                            *RuntimeServices;
+    EFI_BOOT_SERVICES               *BootServices;
+    UINTN                           NumberOfTableEntries;
+    VOID                            *ConfigurationTable;
+} EFI_SYSTEM_TABLE;
+
+// Loaded image protocol
+#define EFI_LOADED_IMAGE_PROTOCOL_GUID \
+    { 0x5B1B31A1, 0x9562, 0x11D2, { 0x8E, 0x3F, 0x00, 0xA0, 0xC9, 0x69, 0x72, 0x3B } }
+
+typedef struct {
+    UINT32            Revision;
+    EFI_HANDLE        ParentHandle;
+    EFI_SYSTEM_TABLE  *SystemTable;
+    EFI_HANDLE        DeviceHandle;
+    VOID              *FilePath;
+    VOID              *Reserved;
+    UINT32            LoadOptionsSize;
+    VOID              *LoadOptions;
+    VOID              *ImageBase;
+    UINT64            ImageSize;
+    EFI_MEMORY_TYPE   ImageCodeType;
+    EFI_MEMORY_TYPE   ImageDataType;
+    VOID              *Unload;
+} EFI_LOADED_IMAGE_PROTOCOL;
+
+// File protocol
+#define EFI_FILE_MODE_READ 0x0000000000000001ULL
+
+struct _EFI_FILE_PROTOCOL;
+
+typedef EFI_STATUS (EFIAPI *EFI_FILE_OPEN)(
+    struct _EFI_FILE_PROTOCOL *This, struct _EFI_FILE_PROTOCOL **NewHandle,
+    CHAR16 *FileName, UINT64 OpenMode, UINT64 Attributes);
+typedef EFI_STATUS (EFIAPI *EFI_FILE_CLOSE)(struct _EFI_FILE_PROTOCOL *This);
+typedef EFI_STATUS (EFIAPI *EFI_FILE_READ)(
+    struct _EFI_FILE_PROTOCOL *This, UINTN *BufferSize, VOID *Buffer);
+typedef EFI_STATUS (EFIAPI *EFI_FILE_GET_INFO)(
+    struct _EFI_FILE_PROTOCOL *This, EFI_GUID *InformationType, UINTN *BufferSize, VOID *Buffer);
+
+typedef struct _EFI_FILE_PROTOCOL {
+    UINT64            Revision;
+    EFI_FILE_OPEN     Open;
+    EFI_FILE_CLOSE    Close;
+    VOID              *Delete;
+    EFI_FILE_READ     Read;
+    VOID              *Write;
+    VOID              *GetPosition;
+    VOID              *SetPosition;
+    EFI_FILE_GET_INFO GetInfo;
+    VOID              *SetInfo;
+    VOID              *Flush;
+} EFI_FILE_PROTOCOL;
+
+#define EFI_FILE_INFO_GUID \
+    { 0x09576E92, 0x6D3F, 0x11D2, { 0x8E, 0x39, 0x00, 0xA0, 0xC9, 0x69, 0x72, 0x3B } }
+
+typedef struct {
+    UINT16 Year;
+    UINT8  Month;
+    UINT8  Day;
+    UINT8  Hour;
+    UINT8  Minute;
+    UINT8  Second;
+    UINT8  Pad1;
+    UINT32 Nanosecond;
+    INT16  TimeZone;
+    UINT8  Daylight;
+    UINT8  Pad2;
+} EFI_TIME;
+
+typedef struct {
+    UINT64   Size;
+    UINT64   FileSize;
+    UINT64   PhysicalSize;
+    EFI_TIME CreateTime;
+    EFI_TIME LastAccessTime;
+    EFI_TIME ModificationTime;
+    UINT64   Attribute;
+    CHAR16   FileName[1];
+} EFI_FILE_INFO;
+
+// Simple file system protocol
+#define EFI_SIMPLE_FILE_SYSTEM_PROTOCOL_GUID \
+    { 0x964E5B22, 0x6459, 0x11D2, { 0x8E, 0x39, 0x00, 0xA0, 0xC9, 0x69, 0x72, 0x3B } }
+
+struct _EFI_SIMPLE_FILE_SYSTEM_PROTOCOL;
+
+typedef EFI_STATUS (EFIAPI *EFI_OPEN_VOLUME)(
+    struct _EFI_SIMPLE_FILE_SYSTEM_PROTOCOL *This, EFI_FILE_PROTOCOL **Root);
+
+typedef struct _EFI_SIMPLE_FILE_SYSTEM_PROTOCOL {
+    UINT64          Revision;
+    EFI_OPEN_VOLUME OpenVolume;
+} EFI_SIMPLE_FILE_SYSTEM_PROTOCOL;
+
+// Graphics output protocol
+#define EFI_GRAPHICS_OUTPUT_PROTOCOL_GUID \
+    { 0x9042A9DE, 0x23DC, 0x4A38, { 0x96, 0xFB, 0x7A, 0xDE, 0xD0, 0x80, 0x51, 0x6A } }
+
+typedef enum {
+    PixelRedGreenBlueReserved8BitPerColor,
+    PixelBlueGreenRedReserved8BitPerColor,
+    PixelBitMask,
+    PixelBltOnly,
+    PixelFormatMax
+} EFI_GRAPHICS_PIXEL_FORMAT;
+
+typedef struct {
+    UINT32 RedMask;
+    UINT32 GreenMask;
+    UINT32 BlueMask;
+    UINT32 ReservedMask;
+} EFI_PIXEL_BITMASK;
+
+typedef struct {
+    UINT32                    Version;
+    UINT32                    HorizontalResolution;
+    UINT32                    VerticalResolution;
+    EFI_GRAPHICS_PIXEL_FORMAT PixelFormat;
+    EFI_PIXEL_BITMASK         PixelInformation;
+    UINT32                    PixelsPerScanLine;
+} EFI_GRAPHICS_OUTPUT_MODE_INFORMATION;
+
+typedef struct {
+    UINT32                               MaxMode;
+    UINT32                               Mode;
+    EFI_GRAPHICS_OUTPUT_MODE_INFORMATION *Info;
+    UINTN                                SizeOfInfo;
+    EFI_PHYSICAL_ADDRESS                 FrameBufferBase;
+    UINTN                                FrameBufferSize;
+} EFI_GRAPHICS_OUTPUT_PROTOCOL_MODE;
+
+typedef struct {
+    VOID                              *QueryMode;
+    VOID                              *SetMode;
+    VOID                              *Blt;
+    EFI_GRAPHICS_OUTPUT_PROTOCOL_MODE *Mode;
+} EFI_GRAPHICS_OUTPUT_PROTOCOL;
+
+#endif // EFI_H
@@ -0,0 +1,249 @@
+// CrusadeOS UEFI Bootloader
+// PE/COFF application: takes the GOP framebuffer, reads the kernel from the
+// ESP in a single file read, exits boot services and hands over BOOT_INFO
+
+#include "efi.h"
+
+// Kernel location on the ESP
+#define KERNEL_PATH L"\\CrusadeOS\\kernel.bin"
+
+// Kernel entry point uses the System V ABI (rdi = BOOT_INFO*)
+typedef void (__attribute__((sysv_abi)) *KERNEL_ENTRY_POINT)(BOOT_INFO *BootInfo);
+
+static EFI_SYSTEM_TABLE  *gST;
+static EFI_BOOT_SERVICES *gBS;
+
+static EFI_GUID gGraphicsOutputGuid = EFI_GRAPHICS_OUTPUT_PROTOCOL_GUID;
+static EFI_GUID gLoadedImageGuid    = EFI_LOADED_IMAGE_PROTOCOL_GUID;
+static EFI_GUID gFileSystemGuid     = EFI_SIMPLE_FILE_SYSTEM_PROTOCOL_GUID;
+static EFI_GUID gFileInfoGuid       = EFI_FILE_INFO_GUID;
+
+// Print a message on the firmware console
+static void efi_print(CHAR16 *Message) {
+    gST->ConOut->OutputString(gST->ConOut, Message);
+}
+
+// Print an error and return its status to the firmware
+static EFI_STATUS efi_fail(CHAR16 *Message, EFI_STATUS Status) {
+    efi_print(Message);
+    efi_print(L"\r\nReturning to firmware.\r\n");
+    return Status;
+}
+
+// Take over the current GOP mode as a linear framebuffer
+static EFI_STATUS init_graphics(GRAPHICS_INFO *Graphics) {
+    EFI_GRAPHICS_OUTPUT_PROTOCOL *Gop;
+    EFI_STATUS Status = gBS->LocateProtocol(&gGraphicsOutputGuid, NULL, (VOID **)&Gop);
+    if (EFI_ERROR(Status)) {
+        return Status;
+    }
+
+    // The kernel palette is 0x00RRGGBB, so only 32bpp BGRX framebuffers work
+    EFI_GRAPHICS_OUTPUT_MODE_INFORMATION *Info = Gop->Mode->Info;
+    EFI_PIXEL_BITMASK *Mask = &Info->PixelInformation;
+    BOOLEAN IsBgrx = Info->PixelFormat == PixelBlueGreenRedReserved8BitPerColor ||
+                     (Info->PixelFormat == PixelBitMask &&
+                      Mask->RedMask == 0x00FF0000 && Mask->GreenMask == 0x0000FF00 &&
+                      Mask->BlueMask == 0x000000FF);
+    if (!IsBgrx) {
+        return EFI_UNSUPPORTED;
+    }
+
+    Graphics->HorizontalResolution = Info->HorizontalResolution;
+    Graphics->VerticalResolution   = Info->VerticalResolution;
+    Graphics->BitsPerPixel         = 32;
+    Graphics->FrameBufferBase      = Gop->Mode->FrameBufferBase;
+    Graphics->FrameBufferSize      = Gop->Mode->FrameBufferSize;
+    Graphics->PixelsPerScanLine    = Info->PixelsPerScanLine;
+    return EFI_SUCCESS;
+}
+
+// Read the kernel image to its link address with one file read
+static EFI_STATUS load_kernel(EFI_HANDLE ImageHandle, KERNEL_INFO *Kernel) {
+    EFI_LOADED_IMAGE_PROTOCOL *LoadedImage;
+    EFI_SIMPLE_FILE_SYSTEM_PROTOCOL *FileSystem;
+    EFI_FILE_PROTOCOL *Root;
+    EFI_FILE_PROTOCOL *File;
+    EFI_STATUS Status;
+
+    // Open the volume this loader was started from (the ESP)
+    Status = gBS->HandleProtocol(ImageHandle, &gLoadedImageGuid, (VOID **)&LoadedImage);
+    if (EFI_ERROR(Status)) return Status;
+    Status = gBS->HandleProtocol(LoadedImage->DeviceHandle, &gFileSystemGuid, (VOID **)&FileSystem);
+    if (EFI_ERROR(Status)) return Status;
+    Status = FileSystem->OpenVolume(FileSystem, &Root);
+    if (EFI_ERROR(Status)) return Status;
+
+    Status = Root->Open(Root, &File, KERNEL_PATH, EFI_FILE_MODE_READ, 0);
+    Root->Close(Root);
+    if (EFI_ERROR(Status)) return Status;
+
+    // Query file size
+    UINT64 InfoBuffer[32];
+    UINTN InfoSize = sizeof(InfoBuffer);
+    Status = File->GetInfo(File, &gFileInfoGuid, &InfoSize, InfoBuffer);
+    if (EFI_ERROR(Status)) {
+        File->Close(File);
+        return Status;
+    }
+    UINTN FileSize = ((EFI_FILE_INFO *)InfoBuffer)->FileSize;
+    if (FileSize < sizeof(KERNEL_IMAGE_HEADER) || FileSize > KERNEL_RESERVED_SIZE) {
+        File->Close(File);
+        return EFI_LOAD_ERROR;
+    }
+
+    // Reserve the kernel image, BSS and stack at the link address
+    EFI_PHYSICAL_ADDRESS Base = KERNEL_LOAD_ADDRESS;
+    Status = gBS->AllocatePages(AllocateAddress, EfiLoaderCode,
+                                KERNEL_RESERVED_SIZE / EFI_PAGE_SIZE, &Base);
+    if (EFI_ERROR(Status)) {
+        File->Close(File);
+        return Status;
+    }
+
+    UINTN ReadSize = FileSize;
+    Status = File->Read(File, &ReadSize, (VOID *)(UINTN)Base);
+    File->Close(File);
+    if (!EFI_ERROR(Status) && ReadSize != FileSize) {
+        Status = EFI_LOAD_ERROR;
+    }
+
+    // BSS and stack follow the file, so check the linked image end
+    KERNEL_IMAGE_HEADER *Header = (KERNEL_IMAGE_HEADER *)(UINTN)Base;
+    if (!EFI_ERROR(Status) &&
+        (Header->Magic != KERNEL_IMAGE_MAGIC ||
+         Header->ImageEnd < Base + FileSize ||
+         Header->ImageEnd - Base > KERNEL_RESERVED_SIZE)) {
+        Status = EFI_LOAD_ERROR;
+    }
+    if (EFI_ERROR(Status)) {
+        gBS->FreePages(Base, KERNEL_RESERVED_SIZE / EFI_PAGE_SIZE);
+        return Status;
+    }
+
+    Kernel->BaseAddress = Base;
+    Kernel->Size        = FileSize;
+    Kernel->EntryPoint  = Base;
+    return EFI_SUCCESS;
+}
+
+// Allocate a buffer large enough for the final memory map
+static EFI_STATUS alloc_memory_map(EFI_MEMORY_DESCRIPTOR **Map, UINTN *BufferSize) {
+    UINTN MapSize = 0;
+    UINTN MapKey;
+    UINTN DescriptorSize;
+    UINT32 DescriptorVersion;
+    EFI_STATUS Status;
+
+    // Size the map, leaving room for the pool allocation below
+    Status = gBS->GetMemoryMap(&MapSize, NULL, &MapKey, &DescriptorSize, &DescriptorVersion);
+    if (Status != EFI_BUFFER_TOO_SMALL) return EFI_ERROR(Status) ? Status : EFI_LOAD_ERROR;
+    *BufferSize = MapSize + 4 * DescriptorSize;
+
+    return gBS->AllocatePool(EfiLoaderData, *BufferSize, (VOID **)Map);
+}
+
+// Fetch the final memory map and leave boot services
+// On failure boot services may already be gone, so the caller must not use them
+static EFI_STATUS exit_boot_services(EFI_HANDLE ImageHandle, EFI_MEMORY_DESCRIPTOR *Map,
+                                     UINTN BufferSize, BOOTLOADER_MEMORY_INFO *Memory) {
+    UINTN MapSize;
+    UINTN MapKey;
+    UINTN DescriptorSize;
+    UINT32 DescriptorVersion;
+    EFI_STATUS Status = EFI_LOAD_ERROR;
+
+    // The map key can go stale between the calls, so retry once
+    for (int Attempt = 0; Attempt < 2; Attempt++) {
+        MapSize = BufferSize;
+        Status = gBS->GetMemoryMap(&MapSize, Map, &MapKey, &DescriptorSize, &DescriptorVersion);
+        if (EFI_ERROR(Status)) return Status;
+
+        Status = gBS->ExitBootServices(ImageHandle, MapKey);
+        if (!EFI_ERROR(Status)) break;
+    }
+    if (EFI_ERROR(Status)) return Status;
+
+    // Count memory usable by the kernel
+    UINT64 UsablePages = 0;
+    for (UINTN Offset = 0; Offset < MapSize; Offset += DescriptorSize) {
+        EFI_MEMORY_DESCRIPTOR *Desc = (EFI_MEMORY_DESCRIPTOR *)((UINT8 *)Map + Offset);
+        switch (Desc->Type) {
+            case EfiLoaderCode:
+            case EfiLoaderData:
+            case EfiBootServicesCode:
+            case EfiBootServicesData:
+            case EfiConventionalMemory:
+                UsablePages += Desc->NumberOfPages;
+                break;
+        }
+    }
+
+    Memory->MemoryMap         = Map;
+    Memory->MemoryMapSize     = MapSize;
+    Memory->DescriptorSize    = DescriptorSize;
+    Memory->DescriptorVersion = DescriptorVersion;
+    Memory->MapKey            = MapKey;
+    Memory->TotalMemoryMB     = (UINT32)((UsablePages * EFI_PAGE_SIZE) >> 20);
+    return EFI_SUCCESS;
+}
+
+// UEFI application entry point
+EFI_STATUS EFIAPI efi_main(EFI_HANDLE ImageHandle, EFI_SYSTEM_TABLE *SystemTable) {
+    BOOT_INFO *BootInfo;
+    EFI_STATUS Status;
+
+    gST = SystemTable;
+    gBS = SystemTable->BootServices;
+
+    efi_print(L"CrusadeOS UEFI Bootloader\r\n");
+
+    // Don't let the firmware reset us while loading
+    gBS->SetWatchdogTimer(0, 0, 0, NULL);
+
+    Status = gBS->AllocatePool(EfiLoaderData, sizeof(BOOT_INFO), (VOID **)&BootInfo);
+    if (EFI_ERROR(Status)) {
+        return efi_fail(L"Out of memory!", Status);
+    }
+
+    Status = init_graphics(&BootInfo->Graphics);
+    if (EFI_ERROR(Status)) {
+        gBS->FreePool(BootInfo);
+        return efi_fail(L"No 32bpp BGRX GOP framebuffer!", Status);
+    }
+
+    efi_print(L"Loading kernel...\r\n");
+    Status = load_kernel(ImageHandle, &BootInfo->Kernel);
+    if (EFI_ERROR(Status)) {
+        gBS->FreePool(BootInfo);
+        return efi_fail(L"Cannot load " KERNEL_PATH L"!", Status);
+    }
+
+    EFI_MEMORY_DESCRIPTOR *Map = NULL;
+    UINTN MapBufferSize = 0;
+    Status = alloc_memory_map(&Map, &MapBufferSize);
+    if (EFI_ERROR(Status)) {
+        gBS->FreePages(BootInfo->Kernel.BaseAddress, KERNEL_RESERVED_SIZE / EFI_PAGE_SIZE);
+        gBS->FreePool(BootInfo);
+        return efi_fail(L"Cannot read memory map!", Status);
+    }
+
+    // No firmware services (including ConOut) past this point, even if
+    // ExitBootServices failed
+    Status = exit_boot_services(ImageHandle, Map, MapBufferSize, &BootInfo->Memory);
+    asm volatile ("cli");
+    if (EFI_ERROR(Status)) {
+        while (1) {
+            asm volatile ("hlt");
+        }
+    }
+
+    // Jump to kernel
+    KERNEL_ENTRY_POINT EntryPoint = (KERNEL_ENTRY_POINT)(UINTN)BootInfo->Kernel.EntryPoint;
+    EntryPoint(BootInfo);
+
+    // Should never reach here
+    while (1) {
+        asm volatile ("hlt");
+    }
+}
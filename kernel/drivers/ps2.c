@@ -0,0 +1,216 @@
+// CrusadeOS PS/2 Driver - Keyboard and mouse
+// Polled i8042 controller (interrupts stay disabled), ported from the
+// original assembly kernel
+
+#include "../kernel.h"
+
+// PS/2 Controller ports
+#define PS2_DATA_PORT    0x60
+#define PS2_STATUS_PORT  0x64
+#define PS2_COMMAND_PORT 0x64
+
+// Status register bits
+#define PS2_STATUS_OUTPUT_FULL 0x01
+#define PS2_STATUS_INPUT_FULL  0x02
+#define PS2_STATUS_MOUSE_DATA  0x20
+
+// Give up on a missing or stuck controller instead of hanging the boot
+#define PS2_TIMEOUT 100000
+
+// Bytes handled per poll (a missing controller reads back 0xFF forever)
+#define PS2_POLL_LIMIT 64
+
+// Mouse sensitivity divisor (higher = slower)
+#define MOUSE_SENSITIVITY 2
+
+// Keyboard buffer size
+#define KEY_BUFFER_SIZE 16
+
+// Mouse state (position in text cells)
+static MOUSE_STATE mouse = { VGA_WIDTH / 2, VGA_HEIGHT / 2, FALSE, FALSE, FALSE, 0 };
+static int mouse_packet_state = 0;
+static UINT8 mouse_packet_data[3];
+
+// Keyboard ring buffer
+static char key_buffer[KEY_BUFFER_SIZE];
+static int key_head = 0;
+static int key_tail = 0;
+
+// Scancode set 1 to ASCII (make codes only, letters upper case)
+static const char scancode_map[0x3A] = {
+    0,    0,   '1', '2', '3', '4', '5', '6', '7', '8', '9', '0', '-', '=', '\b', 0,
+    'Q', 'W', 'E', 'R', 'T', 'Y', 'U', 'I', 'O', 'P', '[', ']', '\n', 0,  'A', 'S',
+    'D', 'F', 'G', 'H', 'J', 'K', 'L', ';', '\'', '`', 0,  '\\', 'Z', 'X', 'C', 'V',
+    'B', 'N', 'M', ',', '.', '/', 0,   '*', 0,   ' '
+};
+
+// ============= PORT I/O =============
+
+static inline UINT8 inb(UINT16 port) {
+    UINT8 value;
+    asm volatile ("inb %1, %0" : "=a"(value) : "Nd"(port));
+    return value;
+}
+
+static inline void outb(UINT16 port, UINT8 value) {
+    asm volatile ("outb %0, %1" : : "a"(value), "Nd"(port));
+}
+
+// Wait for PS/2 input buffer to be empty
+static BOOLEAN ps2_wait_input(void) {
+    for (int i = 0; i < PS2_TIMEOUT; i++) {
+        if (!(inb(PS2_STATUS_PORT) & PS2_STATUS_INPUT_FULL)) return TRUE;
+    }
+    return FALSE;
+}
+
+// Wait for PS/2 output buffer to be full
+static BOOLEAN ps2_wait_output(void) {
+    for (int i = 0; i < PS2_TIMEOUT; i++) {
+        if (inb(PS2_STATUS_PORT) & PS2_STATUS_OUTPUT_FULL) return TRUE;
+    }
+    return FALSE;
+}
+
+static void ps2_command(UINT8 command) {
+    ps2_wait_input();
+    outb(PS2_COMMAND_PORT, command);
+}
+
+static UINT8 ps2_read(void) {
+    ps2_wait_output();
+    return inb(PS2_DATA_PORT);
+}
+
+static void ps2_write(UINT8 value) {
+    ps2_wait_input();
+    outb(PS2_DATA_PORT, value);
+}
+
+// Send a byte to the mouse and read its ACK
+static UINT8 ps2_mouse_write(UINT8 value) {
+    ps2_command(0xD4);  // Next byte goes to mouse
+    ps2_write(value);
+    return ps2_read();
+}
+
+// ============= INITIALIZATION =============
+
+// Initialize PS/2 controller
+static void ps2_init_controller(void) {
+    // Disable both ports while configuring
+    ps2_command(0xAD);
+    ps2_command(0xA7);
+
+    // Flush output buffer
+    for (int i = 0; i < PS2_POLL_LIMIT && (inb(PS2_STATUS_PORT) & PS2_STATUS_OUTPUT_FULL); i++) {
+        inb(PS2_DATA_PORT);
+    }
+
+    // Polled mode: no IRQs, both clocks on, translation to scancode set 1
+    ps2_command(0x20);
+    UINT8 config = ps2_read();
+    config &= ~(0x01 | 0x02 | 0x10 | 0x20);
+    config |= 0x40;
+    ps2_command(0x60);
+    ps2_write(config);
+
+    // Enable both ports
+    ps2_command(0xAE);
+    ps2_command(0xA8);
+}
+
+// Initialize PS/2 mouse
+static void ps2_init_mouse(void) {
+    // Reset: ACK, self-test result, mouse ID
+    ps2_mouse_write(0xFF);
+    ps2_read();
+    ps2_read();
+
+    ps2_mouse_write(0xF6);  // Set defaults
+
+    // Sample rate 100 (good balance of responsiveness and stability)
+    ps2_mouse_write(0xF3);
+    ps2_mouse_write(100);
+
+    ps2_mouse_write(0xF4);  // Enable data reporting
+}
+
+void ps2_init(void) {
+    ps2_init_controller();
+    ps2_init_mouse();
+}
+
+// ============= INPUT =============
+
+static void ps2_handle_key(UINT8 scancode) {
+    // Ignore key releases and unmapped keys
+    if (scancode >= sizeof(scancode_map) || !scancode_map[scancode]) return;
+
+    int next = (key_head + 1) % KEY_BUFFER_SIZE;
+    if (next == key_tail) return;  // Buffer full
+    key_buffer[key_head] = scancode_map[scancode];
+    key_head = next;
+}
+
+// Process complete 3-byte mouse packet
+static void ps2_handle_mouse_packet(void) {
+    UINT8 flags = mouse_packet_data[0];
+    mouse.LeftButton   = (flags & 0x01) != 0;
+    mouse.RightButton  = (flags & 0x02) != 0;
+    mouse.MiddleButton = (flags & 0x04) != 0;
+
+    // Drop movement on overflow
+    if (flags & 0xC0) return;
+
+    // Y is inverted for screen coordinates
+    int x = (int)mouse.X + (INT8)mouse_packet_data[1] / MOUSE_SENSITIVITY;
+    int y = (int)mouse.Y - (INT8)mouse_packet_data[2] / MOUSE_SENSITIVITY;
+
+    // Keep mouse within screen bounds
+    if (x < 0) x = 0;
+    if (x > VGA_WIDTH - 1) x = VGA_WIDTH - 1;
+    if (y < 0) y = 0;
+    if (y > VGA_HEIGHT - 1) y = VGA_HEIGHT - 1;
+    mouse.X = x;
+    mouse.Y = y;
+}
+
+static void ps2_handle_mouse_byte(UINT8 data) {
+    // Byte 0 always has bit 3 set; skip bytes until we are back in sync
+    if (mouse_packet_state == 0 && !(data & 0x08)) return;
+
+    mouse_packet_data[mouse_packet_state++] = data;
+    if (mouse_packet_state == 3) {
+        mouse_packet_state = 0;
+        ps2_handle_mouse_packet();
+    }
+}
+
+// Drain pending keyboard and mouse bytes
+void ps2_poll(void) {
+    for (int i = 0; i < PS2_POLL_LIMIT; i++) {
+        UINT8 status = inb(PS2_STATUS_PORT);
+        if (!(status & PS2_STATUS_OUTPUT_FULL)) break;
+
+        UINT8 data = inb(PS2_DATA_PORT);
+        if (status & PS2_STATUS_MOUSE_DATA) {
+            ps2_handle_mouse_byte(data);
+        } else {
+            ps2_handle_key(data);
+        }
+    }
+}
+
+// Next typed character, 0 if none
+char ps2_read_key(void) {
+    if (key_tail == key_head) return 0;
+    char c = key_buffer[key_tail];
+    key_tail = (key_tail + 1) % KEY_BUFFER_SIZE;
+    return c;
+}
+
+// Current mouse position and buttons
+const MOUSE_STATE* ps2_mouse_state(void) {
+    return &mouse;
+}
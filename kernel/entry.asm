@@ -0,0 +1,43 @@
+; CrusadeOS 64-bit Kernel Entry
+; Placed first in the image (.text.startup); the bootloader jumps here in long mode
+; RDI = BOOT_INFO* from the UEFI loader, or 0 from the BIOS bootloader
+
+[BITS 64]
+
+section .text.startup
+
+global _start
+extern kernel_main
+extern _bss_start
+extern _bss_end
+extern _stack_top
+
+; Image header, read by the UEFI loader (must match KERNEL_IMAGE_HEADER)
+KERNEL_IMAGE_MAGIC equ 'CRUSADOS'
+
+_start:
+    jmp short .entry
+    align 8
+    dq KERNEL_IMAGE_MAGIC
+    dq _stack_top       ; End of image, BSS and stack
+
+.entry:
+    cli
+    mov rsp, _stack_top ; Kernel stack from kernel.ld
+    xor ebp, ebp
+    mov rbx, rdi        ; Save BOOT_INFO pointer
+
+    ; Clear BSS (not stored in the flat binary)
+    mov rdi, _bss_start
+    mov rcx, _bss_end
+    sub rcx, rdi
+    xor eax, eax
+    rep stosb
+
+    mov rdi, rbx
+    call kernel_main
+
+    ; Should never reach here
+.hang:
+    hlt
+    jmp .hang
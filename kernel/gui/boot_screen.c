@@ -3,19 +3,8 @@
 
 #include "../kernel.h"
 
-// Boot screen phases
-typedef enum {
-    BOOT_PHASE_LOGO,
-    BOOT_PHASE_LOADING,
-    BOOT_PHASE_SERVICES,
-    BOOT_PHASE_COMPLETE
-} boot_phase_t;
-
-static boot_phase_t current_phase = BOOT_PHASE_LOGO;
-static int boot_progress = 0;
-
 // Draw CrusadeOS logo
-void boot_draw_logo(void) {
+void boot_draw_logo(BOOT_INFO* boot_info) {
     vga_clear_screen(vga_color(VGA_COLOR_WHITE, VGA_COLOR_BLACK));
     
     // ASCII art logo
@@ -43,9 +32,10 @@ void boot_draw_logo(void) {
     vga_set_cursor(33, 13);
     vga_print("Version 0.1.0", vga_color(VGA_COLOR_WHITE, VGA_COLOR_BLACK));
     
-    // Copyright
+    // Boot path (BOOT_INFO only comes from the UEFI loader)
     vga_set_cursor(29, 15);
-    vga_print("BIOS Boot System Ready", vga_color(VGA_COLOR_LIGHT_GREY, VGA_COLOR_BLACK));
+    vga_print(boot_info ? "UEFI Boot System Ready" : "BIOS Boot System Ready",
+              vga_color(VGA_COLOR_LIGHT_GREY, VGA_COLOR_BLACK));
 }
 
 // Draw loading bar
@@ -95,7 +85,7 @@ void boot_delay(int cycles) {
 }
 
 // Run boot sequence
-void boot_screen_run(void) {
+void boot_screen_run(BOOT_INFO* boot_info) {
     const char* boot_messages[] = {
         "Initializing Kernel...",
         "Loading VGA Driver...",
@@ -109,7 +99,7 @@ void boot_screen_run(void) {
     int num_messages = sizeof(boot_messages) / sizeof(boot_messages[0]);
     
     // Show logo
-    boot_draw_logo();
+    boot_draw_logo(boot_info);
     boot_delay(20);
     
     // Loading phase
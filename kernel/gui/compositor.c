@@ -0,0 +1,439 @@
+// CrusadeOS Compositor - Batched draw command lists
+// Apps record fill/rect/text/blit commands into a per-window list; once per
+// frame the compositor sorts windows by z, drops commands hidden by windows
+// above, merges adjacent fills and executes everything in one pass into a
+// back buffer. Changes to a window damage its bounds, and a frame only
+// re-executes, clears and presents the damaged rectangle.
+
+#include "../kernel.h"
+
+// Draw command types
+typedef enum {
+    DRAW_CMD_FILL,
+    DRAW_CMD_RECT,
+    DRAW_CMD_TEXT,
+    DRAW_CMD_BLIT
+} draw_cmd_type_t;
+
+// Draw command (coordinates relative to the window)
+typedef struct {
+    draw_cmd_type_t type;
+    int x, y, width, height;
+    char c;
+    unsigned char color;
+    const char* text;
+    const unsigned short* cells;
+} draw_cmd_t;
+
+// Per-window command list
+struct draw_list {
+    int x, y, width, height;    // Screen bounds, also the clip rectangle
+    int z;                      // Higher z is drawn on top
+    int order;                  // Creation order, breaks z ties
+    BOOLEAN in_use;
+    BOOLEAN visible;
+    int count;
+    draw_cmd_t commands[DRAW_LIST_MAX_COMMANDS];
+};
+
+// Screen rectangle
+typedef struct {
+    int x0, y0, x1, y1;         // x1/y1 exclusive
+} rect_t;
+
+// Command resolved to screen space for the current frame
+typedef struct {
+    draw_cmd_type_t type;
+    int x, y, width, height;    // Unclipped screen position
+    rect_t bounds;              // Clipped area actually touched
+    char c;
+    unsigned char color;
+    const char* text;
+    const unsigned short* cells;
+} frame_cmd_t;
+
+static draw_list_t windows[COMPOSITOR_MAX_WINDOWS];
+static draw_list_t* sorted[COMPOSITOR_MAX_WINDOWS];
+static frame_cmd_t frame_cmds[COMPOSITOR_MAX_FRAME_COMMANDS];
+static int frame_count = 0;
+static int next_order = 0;
+
+// Area to recomposite next frame (union of damaged window bounds)
+static rect_t damage;
+static BOOLEAN has_damage = FALSE;
+
+// Back buffer and last presented frame (char | attr << 8, like VGA memory)
+static unsigned short back_buffer[VGA_WIDTH * VGA_HEIGHT];
+static unsigned short front_buffer[VGA_WIDTH * VGA_HEIGHT];
+static BOOLEAN front_valid = FALSE;
+
+// Rectangle helpers
+static rect_t rect_make(int x, int y, int width, int height) {
+    rect_t r = { x, y, x + width, y + height };
+    return r;
+}
+
+static rect_t rect_intersect(rect_t a, rect_t b) {
+    rect_t r;
+    r.x0 = (a.x0 > b.x0) ? a.x0 : b.x0;
+    r.y0 = (a.y0 > b.y0) ? a.y0 : b.y0;
+    r.x1 = (a.x1 < b.x1) ? a.x1 : b.x1;
+    r.y1 = (a.y1 < b.y1) ? a.y1 : b.y1;
+    return r;
+}
+
+static BOOLEAN rect_empty(rect_t r) {
+    return r.x0 >= r.x1 || r.y0 >= r.y1;
+}
+
+static BOOLEAN rect_contains(rect_t outer, rect_t inner) {
+    return inner.x0 >= outer.x0 && inner.y0 >= outer.y0 &&
+           inner.x1 <= outer.x1 && inner.y1 <= outer.y1;
+}
+
+static rect_t window_clip(draw_list_t* list) {
+    return rect_intersect(rect_make(list->x, list->y, list->width, list->height),
+                          rect_make(0, 0, VGA_WIDTH, VGA_HEIGHT));
+}
+
+// Add an area to the next frame's damage
+static void compositor_damage(rect_t area) {
+    if (rect_empty(area)) return;
+    if (!has_damage) {
+        damage = area;
+        has_damage = TRUE;
+        return;
+    }
+    damage.x0 = (damage.x0 < area.x0) ? damage.x0 : area.x0;
+    damage.y0 = (damage.y0 < area.y0) ? damage.y0 : area.y0;
+    damage.x1 = (damage.x1 > area.x1) ? damage.x1 : area.x1;
+    damage.y1 = (damage.y1 > area.y1) ? damage.y1 : area.y1;
+}
+
+// Damage a window's screen bounds if it is on screen
+static void compositor_damage_window(draw_list_t* list) {
+    if (list->in_use && list->visible) {
+        compositor_damage(window_clip(list));
+    }
+}
+
+// Screen area a command touches, clipped to its window
+static rect_t command_bounds(draw_list_t* list, draw_cmd_t* cmd) {
+    int width = cmd->width;
+    if (cmd->type == DRAW_CMD_TEXT) {
+        width = 0;
+        while (cmd->text[width]) width++;
+    }
+    return rect_intersect(rect_make(list->x + cmd->x, list->y + cmd->y, width, cmd->height),
+                          window_clip(list));
+}
+
+// ============= WINDOW MANAGEMENT =============
+
+// Create a window with an empty command list
+// Windows are opaque: nothing below a window's bounds is ever visible
+draw_list_t* compositor_create_window(int x, int y, int width, int height, int z) {
+    for (int i = 0; i < COMPOSITOR_MAX_WINDOWS; i++) {
+        draw_list_t* list = &windows[i];
+        if (!list->in_use) {
+            list->x = x;
+            list->y = y;
+            list->width = width;
+            list->height = height;
+            list->z = z;
+            list->order = next_order++;
+            list->in_use = TRUE;
+            list->visible = TRUE;
+            list->count = 0;
+            compositor_damage_window(list);
+            return list;
+        }
+    }
+    return NULL;
+}
+
+// Close a window and release its list
+void compositor_destroy_window(draw_list_t* list) {
+    if (!list) return;
+    compositor_damage_window(list);
+    list->in_use = FALSE;
+    list->count = 0;
+}
+
+// Show or hide a window without discarding its commands
+void compositor_set_visible(draw_list_t* list, BOOLEAN visible) {
+    if (!list || list->visible == visible) return;
+    list->visible = visible;
+    compositor_damage(window_clip(list));
+}
+
+// Move a window, keeping its commands (they are window-relative)
+void compositor_move_window(draw_list_t* list, int x, int y) {
+    if (!list || (list->x == x && list->y == y)) return;
+    compositor_damage_window(list);
+    list->x = x;
+    list->y = y;
+    compositor_damage_window(list);
+}
+
+// ============= COMMAND RECORDING =============
+
+static draw_cmd_t* draw_list_append(draw_list_t* list, draw_cmd_type_t type) {
+    if (!list || list->count >= DRAW_LIST_MAX_COMMANDS) {
+        return NULL;
+    }
+    draw_cmd_t* cmd = &list->commands[list->count++];
+    cmd->type = type;
+    cmd->x = 0;
+    cmd->y = 0;
+    cmd->width = 0;
+    cmd->height = 1;
+    cmd->c = ' ';
+    cmd->color = 0;
+    cmd->text = NULL;
+    cmd->cells = NULL;
+    compositor_damage_window(list);
+    return cmd;
+}
+
+// Discard all recorded commands so the window can be re-recorded
+void draw_list_reset(draw_list_t* list) {
+    if (!list) return;
+    list->count = 0;
+    compositor_damage_window(list);
+}
+
+// Record a filled rectangle
+void draw_list_fill(draw_list_t* list, int x, int y, int width, int height, char c, unsigned char color) {
+    draw_cmd_t* cmd = draw_list_append(list, DRAW_CMD_FILL);
+    if (!cmd) return;
+    cmd->x = x;
+    cmd->y = y;
+    cmd->width = width;
+    cmd->height = height;
+    cmd->c = c;
+    cmd->color = color;
+}
+
+// Record a rectangle outline
+void draw_list_rect(draw_list_t* list, int x, int y, int width, int height, char c, unsigned char color) {
+    draw_cmd_t* cmd = draw_list_append(list, DRAW_CMD_RECT);
+    if (!cmd) return;
+    cmd->x = x;
+    cmd->y = y;
+    cmd->width = width;
+    cmd->height = height;
+    cmd->c = c;
+    cmd->color = color;
+}
+
+// Record a single-row string (must stay valid until the list is reset)
+void draw_list_text(draw_list_t* list, int x, int y, const char* text, unsigned char color) {
+    draw_cmd_t* cmd = draw_list_append(list, DRAW_CMD_TEXT);
+    if (!cmd) return;
+    cmd->x = x;
+    cmd->y = y;
+    cmd->text = text;
+    cmd->color = color;
+}
+
+// Record a block copy of width * height cells (must stay valid until reset)
+void draw_list_blit(draw_list_t* list, int x, int y, int width, int height, const unsigned short* cells) {
+    draw_cmd_t* cmd = draw_list_append(list, DRAW_CMD_BLIT);
+    if (!cmd) return;
+    cmd->x = x;
+    cmd->y = y;
+    cmd->width = width;
+    cmd->height = height;
+    cmd->cells = cells;
+}
+
+// ============= FRAME BUILDING =============
+
+// Sort visible windows by z (then creation order), bottom first
+static int compositor_sort_windows(void) {
+    int count = 0;
+    for (int i = 0; i < COMPOSITOR_MAX_WINDOWS; i++) {
+        draw_list_t* list = &windows[i];
+        if (!list->in_use || !list->visible) continue;
+
+        int pos = count++;
+        while (pos > 0 && (sorted[pos - 1]->z > list->z ||
+                           (sorted[pos - 1]->z == list->z && sorted[pos - 1]->order > list->order))) {
+            sorted[pos] = sorted[pos - 1];
+            pos--;
+        }
+        sorted[pos] = list;
+    }
+    return count;
+}
+
+// Is the area fully painted over later in the frame?
+static BOOLEAN compositor_is_covered(int window_index, int window_count, int cmd_index, rect_t area) {
+    // Opaque windows above
+    for (int i = window_index + 1; i < window_count; i++) {
+        if (rect_contains(window_clip(sorted[i]), area)) {
+            return TRUE;
+        }
+    }
+
+    // Later fills in the same window
+    draw_list_t* list = sorted[window_index];
+    for (int i = cmd_index + 1; i < list->count; i++) {
+        draw_cmd_t* cmd = &list->commands[i];
+        if (cmd->type == DRAW_CMD_FILL && rect_contains(command_bounds(list, cmd), area)) {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+// Merge a fill into the previous queued fill when they form one rectangle
+static BOOLEAN compositor_merge_fill(rect_t area, char c, unsigned char color) {
+    if (frame_count == 0) return FALSE;
+
+    frame_cmd_t* prev = &frame_cmds[frame_count - 1];
+    if (prev->type != DRAW_CMD_FILL || prev->c != c || prev->color != color) {
+        return FALSE;
+    }
+
+    rect_t* b = &prev->bounds;
+    BOOLEAN same_rows = b->y0 == area.y0 && b->y1 == area.y1;
+    BOOLEAN same_cols = b->x0 == area.x0 && b->x1 == area.x1;
+    if (same_rows && (b->x1 == area.x0 || area.x1 == b->x0)) {
+        b->x0 = (b->x0 < area.x0) ? b->x0 : area.x0;
+        b->x1 = (b->x1 > area.x1) ? b->x1 : area.x1;
+    } else if (same_cols && (b->y1 == area.y0 || area.y1 == b->y0)) {
+        b->y0 = (b->y0 < area.y0) ? b->y0 : area.y0;
+        b->y1 = (b->y1 > area.y1) ? b->y1 : area.y1;
+    } else if (!rect_contains(*b, area)) {
+        return FALSE;
+    }
+    return TRUE;
+}
+
+// Queue one command for execution
+static void compositor_queue(draw_list_t* list, draw_cmd_t* cmd, rect_t area) {
+    if (cmd->type == DRAW_CMD_FILL && compositor_merge_fill(area, cmd->c, cmd->color)) {
+        return;
+    }
+    if (frame_count >= COMPOSITOR_MAX_FRAME_COMMANDS) {
+        return;
+    }
+
+    frame_cmd_t* out = &frame_cmds[frame_count++];
+    out->type = cmd->type;
+    out->x = list->x + cmd->x;
+    out->y = list->y + cmd->y;
+    out->width = cmd->width;
+    out->height = cmd->height;
+    out->bounds = area;
+    out->c = cmd->c;
+    out->color = cmd->color;
+    out->text = cmd->text;
+    out->cells = cmd->cells;
+}
+
+// Build the frame's command queue: sort, clip to the damage, cull and merge
+static void compositor_build_frame(void) {
+    int window_count = compositor_sort_windows();
+    frame_count = 0;
+
+    for (int w = 0; w < window_count; w++) {
+        draw_list_t* list = sorted[w];
+        for (int i = 0; i < list->count; i++) {
+            draw_cmd_t* cmd = &list->commands[i];
+            rect_t area = rect_intersect(command_bounds(list, cmd), damage);
+            if (rect_empty(area) || compositor_is_covered(w, window_count, i, area)) {
+                continue;
+            }
+            compositor_queue(list, cmd, area);
+        }
+    }
+}
+
+// ============= EXECUTION =============
+
+static void back_fill(rect_t area, unsigned short cell) {
+    for (int y = area.y0; y < area.y1; y++) {
+        unsigned short* row = &back_buffer[y * VGA_WIDTH];
+        for (int x = area.x0; x < area.x1; x++) {
+            row[x] = cell;
+        }
+    }
+}
+
+static void back_put(rect_t clip, int x, int y, unsigned short cell) {
+    if (x >= clip.x0 && x < clip.x1 && y >= clip.y0 && y < clip.y1) {
+        back_buffer[y * VGA_WIDTH + x] = cell;
+    }
+}
+
+static void compositor_execute(frame_cmd_t* cmd) {
+    unsigned short cell = (unsigned char)cmd->c | (cmd->color << 8);
+
+    switch (cmd->type) {
+        case DRAW_CMD_FILL:
+            back_fill(cmd->bounds, cell);
+            break;
+        case DRAW_CMD_RECT:
+            for (int i = 0; i < cmd->width; i++) {
+                back_put(cmd->bounds, cmd->x + i, cmd->y, cell);
+                back_put(cmd->bounds, cmd->x + i, cmd->y + cmd->height - 1, cell);
+            }
+            for (int i = 1; i < cmd->height - 1; i++) {
+                back_put(cmd->bounds, cmd->x, cmd->y + i, cell);
+                back_put(cmd->bounds, cmd->x + cmd->width - 1, cmd->y + i, cell);
+            }
+            break;
+        case DRAW_CMD_TEXT:
+            for (int i = cmd->bounds.x0; i < cmd->bounds.x1; i++) {
+                cell = (unsigned char)cmd->text[i - cmd->x] | (cmd->color << 8);
+                back_buffer[cmd->y * VGA_WIDTH + i] = cell;
+            }
+            break;
+        case DRAW_CMD_BLIT:
+            for (int y = cmd->bounds.y0; y < cmd->bounds.y1; y++) {
+                const unsigned short* src = &cmd->cells[(y - cmd->y) * cmd->width];
+                for (int x = cmd->bounds.x0; x < cmd->bounds.x1; x++) {
+                    back_buffer[y * VGA_WIDTH + x] = src[x - cmd->x];
+                }
+            }
+            break;
+    }
+}
+
+// Push changed cells in the damaged area to the screen
+static void compositor_present(void) {
+    for (int y = damage.y0; y < damage.y1; y++) {
+        for (int x = damage.x0; x < damage.x1; x++) {
+            int i = y * VGA_WIDTH + x;
+            unsigned short cell = back_buffer[i];
+            if (front_valid && front_buffer[i] == cell) continue;
+
+            front_buffer[i] = cell;
+            vga_put_char_at((char)(cell & 0xFF), (unsigned char)(cell >> 8), x, y);
+        }
+    }
+}
+
+// Compose and present one frame (no-op if nothing was damaged since the last)
+void compositor_render(void) {
+    // The first frame replaces whatever was on screen before
+    if (!front_valid) {
+        compositor_damage(rect_make(0, 0, VGA_WIDTH, VGA_HEIGHT));
+    }
+    if (!has_damage) return;
+
+    compositor_build_frame();
+
+    // Cells no window paints stay black
+    back_fill(damage, ' ');
+    for (int i = 0; i < frame_count; i++) {
+        compositor_execute(&frame_cmds[i]);
+    }
+
+    compositor_present();
+    front_valid = TRUE;
+    has_damage = FALSE;
+}
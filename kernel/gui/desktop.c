@@ -5,81 +5,188 @@
 
 // Desktop constants
 #define DESKTOP_COLOR vga_color(VGA_COLOR_WHITE, VGA_COLOR_CYAN)
-#define TASKBAR_COLOR vga_color(VGA_COLOR_WHITE, VGA_COLOR_BLUE)
+#define DESKTOP_TASKBAR_COLOR vga_color(VGA_COLOR_WHITE, VGA_COLOR_BLUE)
 #define TASKBAR_HEIGHT 2
-#define WINDOW_BORDER_COLOR vga_color(VGA_COLOR_WHITE, VGA_COLOR_DARK_GREY)
+#define DESKTOP_WINDOW_BORDER_COLOR vga_color(VGA_COLOR_WHITE, VGA_COLOR_DARK_GREY)
+
+// Compositor layers (windows get z between desktop and taskbar)
+#define DESKTOP_Z 0
+#define TASKBAR_Z 1000
+#define START_MENU_Z (TASKBAR_Z + 1)
+#define CURSOR_Z 2000
+
+// Mouse cursor (arrow in code page 437, white on red)
+#define CURSOR_CHAR 0x10
+#define CURSOR_COLOR vga_color(VGA_COLOR_WHITE, VGA_COLOR_RED)
+
+// Start button on the taskbar
+#define START_BUTTON_X 1
+#define START_BUTTON_WIDTH 9
+
+// Start menu above the start button
+#define START_MENU_X 1
+#define START_MENU_WIDTH 16
+#define START_MENU_HEIGHT 6
+#define START_MENU_Y (VGA_HEIGHT - TASKBAR_HEIGHT - START_MENU_HEIGHT)
+
+// Click messages and typed keys
+#define MESSAGE_X 10
+#define MESSAGE_Y 20
+#define MESSAGE_WIDTH 60
+#define KEYS_X 12
+#define KEYS_MAX 16
+
+// Main loop iterations per clock tick
+#define DESKTOP_CLOCK_FRAMES 1000
+
+#define DESKTOP_MAX_WINDOWS 8
+
+// Desktop icon, clickable on its icon and label rows
+typedef struct {
+    int x0, x1;                 // Columns, inclusive
+    const char* name;
+    const char* message;
+    unsigned char color;
+} desktop_icon_t;
+
+static const desktop_icon_t desktop_icons[] = {
+    {  5, 10, "File Manager", "File Manager Clicked!", VGA_COLOR_LIGHT_RED },
+    { 15, 22, "Terminal",     "Terminal Clicked!",     VGA_COLOR_LIGHT_GREEN },
+    { 25, 32, "Settings",     "Settings Clicked!",     VGA_COLOR_MAGENTA },
+    { 35, 44, "Calculator",   "Calculator Clicked!",   VGA_COLOR_LIGHT_BLUE }
+};
+#define DESKTOP_ICON_COUNT (int)(sizeof(desktop_icons) / sizeof(desktop_icons[0]))
+#define DESKTOP_ICON_Y 8
+
+// Window opened with desktop_draw_window
+typedef struct {
+    draw_list_t* list;
+    int x, y, width, height;
+    int z;                      // Compositor z, slots are reused out of order
+} desktop_window_t;
 
 // Desktop state
 static int desktop_initialized = 0;
+static draw_list_t* desktop_layer = NULL;
+static draw_list_t* clock_layer = NULL;
+static draw_list_t* message_layer = NULL;
+static draw_list_t* keys_layer = NULL;
+static draw_list_t* start_menu = NULL;
+static draw_list_t* cursor_layer = NULL;
+static int next_window_z = DESKTOP_Z + 1;
+static desktop_window_t desktop_windows[DESKTOP_MAX_WINDOWS];
+static char typed_keys[KEYS_MAX + 1];
+static int typed_count = 0;
+static BOOLEAN start_menu_open = FALSE;
+static BOOLEAN left_was_down = FALSE;
 
 // Initialize desktop
 void desktop_init(void) {
+    desktop_layer = compositor_create_window(0, 0, VGA_WIDTH, VGA_HEIGHT, DESKTOP_Z);
+    
     // Clear screen with desktop color
-    vga_clear_screen(DESKTOP_COLOR);
+    draw_list_fill(desktop_layer, 0, 0, VGA_WIDTH, VGA_HEIGHT, ' ', DESKTOP_COLOR);
     
     // Draw taskbar at bottom
-    vga_draw_rect(0, VGA_HEIGHT - TASKBAR_HEIGHT, VGA_WIDTH, TASKBAR_HEIGHT, ' ', TASKBAR_COLOR);
+    draw_list_fill(desktop_layer, 0, VGA_HEIGHT - TASKBAR_HEIGHT, VGA_WIDTH, TASKBAR_HEIGHT, ' ', DESKTOP_TASKBAR_COLOR);
     
     // Draw start button
-    vga_set_cursor(1, VGA_HEIGHT - 2);
-    vga_print("[ START ]", vga_color(VGA_COLOR_YELLOW, VGA_COLOR_BLUE));
+    draw_list_text(desktop_layer, START_BUTTON_X, VGA_HEIGHT - 2, "[ START ]", vga_color(VGA_COLOR_YELLOW, VGA_COLOR_BLUE));
     
-    // Draw clock area
-    vga_set_cursor(VGA_WIDTH - 12, VGA_HEIGHT - 2);
-    vga_print("[ 12:00 ]", vga_color(VGA_COLOR_WHITE, VGA_COLOR_BLUE));
+    // Draw clock area (own layer so ticks only re-record the clock)
+    clock_layer = compositor_create_window(VGA_WIDTH - 12, VGA_HEIGHT - 2, 9, 1, TASKBAR_Z);
+    draw_list_text(clock_layer, 0, 0, "[ 12:00 ]", vga_color(VGA_COLOR_WHITE, VGA_COLOR_BLUE));
     
     // Draw desktop title
-    vga_set_cursor(25, 2);
-    vga_print("CrusadeOS Desktop Environment", vga_color(VGA_COLOR_BLUE, VGA_COLOR_CYAN));
+    draw_list_text(desktop_layer, 25, 2, "CrusadeOS Desktop Environment", vga_color(VGA_COLOR_BLUE, VGA_COLOR_CYAN));
     
     // Draw welcome message
-    vga_set_cursor(30, 4);
-    vga_print("Welcome to CrusadeOS!", vga_color(VGA_COLOR_RED, VGA_COLOR_CYAN));
+    draw_list_text(desktop_layer, 30, 4, "Welcome to CrusadeOS!", vga_color(VGA_COLOR_RED, VGA_COLOR_CYAN));
+    
+    // Draw input help
+    draw_list_text(desktop_layer, 2, 6, "Mouse: Move cursor, Click icons | Keyboard: Type letters",
+                   vga_color(VGA_COLOR_BLACK, VGA_COLOR_CYAN));
+    
+    // Click messages sit on the desktop, below any window
+    message_layer = compositor_create_window(MESSAGE_X, MESSAGE_Y, MESSAGE_WIDTH, 1, DESKTOP_Z);
+    draw_list_fill(message_layer, 0, 0, MESSAGE_WIDTH, 1, ' ', DESKTOP_COLOR);
+    
+    // Typed keys on the taskbar
+    keys_layer = compositor_create_window(KEYS_X, VGA_HEIGHT - 1, 6 + KEYS_MAX, 1, TASKBAR_Z);
+    draw_list_fill(keys_layer, 0, 0, 6 + KEYS_MAX, 1, ' ', DESKTOP_TASKBAR_COLOR);
+    draw_list_text(keys_layer, 0, 0, "Keys: ", DESKTOP_TASKBAR_COLOR);
+    
+    // Start menu, hidden until the start button is clicked
+    start_menu = compositor_create_window(START_MENU_X, START_MENU_Y, START_MENU_WIDTH, START_MENU_HEIGHT, START_MENU_Z);
+    draw_list_fill(start_menu, 0, 0, START_MENU_WIDTH, START_MENU_HEIGHT, ' ', vga_color(VGA_COLOR_BLACK, VGA_COLOR_LIGHT_GREY));
+    draw_list_fill(start_menu, 0, 0, START_MENU_WIDTH, 1, ' ', vga_color(VGA_COLOR_WHITE, VGA_COLOR_BLUE));
+    draw_list_text(start_menu, 1, 0, "CrusadeOS", vga_color(VGA_COLOR_YELLOW, VGA_COLOR_BLUE));
+    for (int i = 0; i < DESKTOP_ICON_COUNT; i++) {
+        draw_list_text(start_menu, 1, 1 + i, desktop_icons[i].name,
+                       vga_color(desktop_icons[i].color, VGA_COLOR_LIGHT_GREY));
+    }
+    compositor_set_visible(start_menu, FALSE);
+    
+    // Mouse cursor above everything
+    const MOUSE_STATE* mouse = ps2_mouse_state();
+    cursor_layer = compositor_create_window(mouse->X, mouse->Y, 1, 1, CURSOR_Z);
+    draw_list_fill(cursor_layer, 0, 0, 1, 1, CURSOR_CHAR, CURSOR_COLOR);
     
     desktop_initialized = 1;
 }
 
-// Draw a simple window
-void desktop_draw_window(int x, int y, int width, int height, const char* title) {
+// Create a simple window, returns its draw list for content
+draw_list_t* desktop_draw_window(int x, int y, int width, int height, const char* title) {
+    desktop_window_t* slot = NULL;
+    for (int i = 0; i < DESKTOP_MAX_WINDOWS; i++) {
+        if (!desktop_windows[i].list) {
+            slot = &desktop_windows[i];
+            break;
+        }
+    }
+    if (!slot) return NULL;
+    
+    draw_list_t* window = compositor_create_window(x, y, width, height, next_window_z);
+    if (!window) return NULL;
+    slot->list = window;
+    slot->z = next_window_z++;
+    slot->x = x;
+    slot->y = y;
+    slot->width = width;
+    slot->height = height;
+    
     // Draw window border
-    vga_draw_rect(x, y, width, height, ' ', vga_color(VGA_COLOR_BLACK, VGA_COLOR_LIGHT_GREY));
+    draw_list_fill(window, 0, 0, width, height, ' ', vga_color(VGA_COLOR_BLACK, VGA_COLOR_LIGHT_GREY));
     
     // Draw title bar
-    vga_draw_rect(x, y, width, 1, ' ', vga_color(VGA_COLOR_WHITE, VGA_COLOR_BLUE));
+    draw_list_fill(window, 0, 0, width, 1, ' ', vga_color(VGA_COLOR_WHITE, VGA_COLOR_BLUE));
     
     // Draw title text
-    vga_set_cursor(x + 2, y);
-    vga_print(title, vga_color(VGA_COLOR_WHITE, VGA_COLOR_BLUE));
+    draw_list_text(window, 2, 0, title, vga_color(VGA_COLOR_WHITE, VGA_COLOR_BLUE));
     
     // Draw close button
-    vga_put_char_at('X', vga_color(VGA_COLOR_WHITE, VGA_COLOR_RED), x + width - 2, y);
+    draw_list_fill(window, width - 2, 0, 1, 1, 'X', vga_color(VGA_COLOR_WHITE, VGA_COLOR_RED));
+    
+    return window;
 }
 
 // Show desktop icons
 void desktop_show_icons(void) {
     // File manager icon
-    vga_set_cursor(5, 8);
-    vga_print("[FILE]", vga_color(VGA_COLOR_YELLOW, VGA_COLOR_CYAN));
-    vga_set_cursor(4, 9);
-    vga_print("Manager", vga_color(VGA_COLOR_BLACK, VGA_COLOR_CYAN));
+    draw_list_text(desktop_layer, 5, 8, "[FILE]", vga_color(VGA_COLOR_YELLOW, VGA_COLOR_CYAN));
+    draw_list_text(desktop_layer, 4, 9, "Manager", vga_color(VGA_COLOR_BLACK, VGA_COLOR_CYAN));
     
     // Terminal icon
-    vga_set_cursor(15, 8);
-    vga_print("[TERM]", vga_color(VGA_COLOR_GREEN, VGA_COLOR_CYAN));
-    vga_set_cursor(14, 9);
-    vga_print("Terminal", vga_color(VGA_COLOR_BLACK, VGA_COLOR_CYAN));
+    draw_list_text(desktop_layer, 15, 8, "[TERM]", vga_color(VGA_COLOR_GREEN, VGA_COLOR_CYAN));
+    draw_list_text(desktop_layer, 14, 9, "Terminal", vga_color(VGA_COLOR_BLACK, VGA_COLOR_CYAN));
     
     // Settings icon
-    vga_set_cursor(25, 8);
-    vga_print("[CONF]", vga_color(VGA_COLOR_MAGENTA, VGA_COLOR_CYAN));
-    vga_set_cursor(24, 9);
-    vga_print("Settings", vga_color(VGA_COLOR_BLACK, VGA_COLOR_CYAN));
+    draw_list_text(desktop_layer, 25, 8, "[CONF]", vga_color(VGA_COLOR_MAGENTA, VGA_COLOR_CYAN));
+    draw_list_text(desktop_layer, 24, 9, "Settings", vga_color(VGA_COLOR_BLACK, VGA_COLOR_CYAN));
     
     // Calculator icon
-    vga_set_cursor(35, 8);
-    vga_print("[CALC]", vga_color(VGA_COLOR_LIGHT_BLUE, VGA_COLOR_CYAN));
-    vga_set_cursor(33, 9);
-    vga_print("Calculator", vga_color(VGA_COLOR_BLACK, VGA_COLOR_CYAN));
+    draw_list_text(desktop_layer, 35, 8, "[CALC]", vga_color(VGA_COLOR_LIGHT_BLUE, VGA_COLOR_CYAN));
+    draw_list_text(desktop_layer, 33, 9, "Calculator", vga_color(VGA_COLOR_BLACK, VGA_COLOR_CYAN));
 }
 
 // Update desktop
@@ -87,43 +194,181 @@ void desktop_update(void) {
     if (!desktop_initialized) return;
     
     // Update clock (simple animation)
+    static const char* clock_text[] = { "[ 12:00 ]", "[ 12:01 ]", "[ 12:02 ]", "[ 12:03 ]" };
     static int clock_state = 0;
     clock_state = (clock_state + 1) % 4;
     
-    vga_set_cursor(VGA_WIDTH - 12, VGA_HEIGHT - 2);
-    switch(clock_state) {
-        case 0: vga_print("[ 12:00 ]", vga_color(VGA_COLOR_WHITE, VGA_COLOR_BLUE)); break;
-        case 1: vga_print("[ 12:01 ]", vga_color(VGA_COLOR_WHITE, VGA_COLOR_BLUE)); break;
-        case 2: vga_print("[ 12:02 ]", vga_color(VGA_COLOR_WHITE, VGA_COLOR_BLUE)); break;
-        case 3: vga_print("[ 12:03 ]", vga_color(VGA_COLOR_WHITE, VGA_COLOR_BLUE)); break;
+    draw_list_reset(clock_layer);
+    draw_list_text(clock_layer, 0, 0, clock_text[clock_state], vga_color(VGA_COLOR_WHITE, VGA_COLOR_BLUE));
+}
+
+// Show a message on the desktop below the icons
+static void desktop_show_message(const char* message, unsigned char color) {
+    draw_list_reset(message_layer);
+    draw_list_fill(message_layer, 0, 0, MESSAGE_WIDTH, 1, ' ', DESKTOP_COLOR);
+    draw_list_text(message_layer, 15, 0, message, vga_color(color, VGA_COLOR_CYAN));
+}
+
+// Close a window opened with desktop_draw_window
+static void desktop_close_window(desktop_window_t* window) {
+    compositor_destroy_window(window->list);
+    window->list = NULL;
+    desktop_show_message("Window Closed!", VGA_COLOR_LIGHT_RED);
+}
+
+static void desktop_toggle_start_menu(BOOLEAN open) {
+    start_menu_open = open;
+    compositor_set_visible(start_menu, open);
+    if (open) {
+        desktop_show_message("Start Menu Opened!", VGA_COLOR_YELLOW);
     }
 }
 
+// Handle a left click at a screen cell, topmost element first
+static void desktop_handle_click(int x, int y) {
+    BOOLEAN on_start_button = y == VGA_HEIGHT - 2 &&
+                              x >= START_BUTTON_X && x < START_BUTTON_X + START_BUTTON_WIDTH;
+    
+    // Start menu items; any click closes the menu, the start button only closes it
+    if (start_menu_open) {
+        desktop_toggle_start_menu(FALSE);
+        if (on_start_button) return;
+        int item = y - START_MENU_Y - 1;
+        if (x >= START_MENU_X && x < START_MENU_X + START_MENU_WIDTH &&
+            item >= 0 && item < DESKTOP_ICON_COUNT) {
+            desktop_show_message(desktop_icons[item].message, desktop_icons[item].color);
+            return;
+        }
+        if (x >= START_MENU_X && x < START_MENU_X + START_MENU_WIDTH &&
+            y >= START_MENU_Y && y < START_MENU_Y + START_MENU_HEIGHT) {
+            return;
+        }
+    }
+    
+    // Windows, topmost (highest z) under the click first; clicks inside a
+    // window stop there
+    desktop_window_t* hit = NULL;
+    for (int i = 0; i < DESKTOP_MAX_WINDOWS; i++) {
+        desktop_window_t* window = &desktop_windows[i];
+        if (!window->list || (hit && hit->z > window->z)) continue;
+        if (x < window->x || x >= window->x + window->width ||
+            y < window->y || y >= window->y + window->height) {
+            continue;
+        }
+        hit = window;
+    }
+    if (hit) {
+        if (x == hit->x + hit->width - 2 && y == hit->y) {
+            desktop_close_window(hit);
+        }
+        return;
+    }
+    
+    // Start button
+    if (on_start_button) {
+        desktop_toggle_start_menu(TRUE);
+        return;
+    }
+    
+    // Desktop icons (icon and label rows)
+    if (y == DESKTOP_ICON_Y || y == DESKTOP_ICON_Y + 1) {
+        for (int i = 0; i < DESKTOP_ICON_COUNT; i++) {
+            if (x >= desktop_icons[i].x0 && x <= desktop_icons[i].x1) {
+                desktop_show_message(desktop_icons[i].message, desktop_icons[i].color);
+                return;
+            }
+        }
+    }
+}
+
+// Show typed characters on the taskbar
+static void desktop_handle_key(char c) {
+    if (c == '\b') {
+        if (typed_count > 0) typed_count--;
+    } else if (c == '\n') {
+        typed_count = 0;
+    } else if (typed_count < KEYS_MAX) {
+        typed_keys[typed_count++] = c;
+    } else {
+        return;
+    }
+    typed_keys[typed_count] = '\0';
+    
+    draw_list_reset(keys_layer);
+    draw_list_fill(keys_layer, 0, 0, 6 + KEYS_MAX, 1, ' ', DESKTOP_TASKBAR_COLOR);
+    draw_list_text(keys_layer, 0, 0, "Keys: ", DESKTOP_TASKBAR_COLOR);
+    draw_list_text(keys_layer, 6, 0, typed_keys, DESKTOP_TASKBAR_COLOR);
+}
+
+// Apply pending keyboard and mouse input
+static void desktop_handle_input(void) {
+    char c;
+    while ((c = ps2_read_key()) != 0) {
+        desktop_handle_key(c);
+    }
+    
+    const MOUSE_STATE* mouse = ps2_mouse_state();
+    compositor_move_window(cursor_layer, mouse->X, mouse->Y);
+    
+    // Act on press only, so holding the button clicks once
+    if (mouse->LeftButton && !left_was_down) {
+        desktop_handle_click(mouse->X, mouse->Y);
+    }
+    left_was_down = mouse->LeftButton;
+}
+
+// Format "Memory: <n>MB" into a static buffer
+static const char* desktop_memory_text(UINT32 megabytes) {
+    static char text[24] = "Memory: ";
+    char digits[10];
+    int count = 0;
+    do {
+        digits[count++] = '0' + megabytes % 10;
+        megabytes /= 10;
+    } while (megabytes);
+    
+    int pos = 8;
+    while (count) text[pos++] = digits[--count];
+    text[pos++] = 'M';
+    text[pos++] = 'B';
+    text[pos] = '\0';
+    return text;
+}
+
 // Run desktop environment
-void desktop_run(void) {
+void desktop_run(BOOT_INFO* boot_info) {
     desktop_init();
     desktop_show_icons();
     
     // Show a demo window
-    desktop_draw_window(45, 12, 30, 8, "CrusadeOS Info");
+    draw_list_t* info = desktop_draw_window(45, 12, 30, 8, "CrusadeOS Info");
     
     // Add content to the window
-    vga_set_cursor(47, 14);
-    vga_print("Version: 0.1.0", vga_color(VGA_COLOR_BLACK, VGA_COLOR_LIGHT_GREY));
-    vga_set_cursor(47, 15);
-    vga_print("Boot: BIOS/MBR", vga_color(VGA_COLOR_BLACK, VGA_COLOR_LIGHT_GREY));
-    vga_set_cursor(47, 16);
-    vga_print("Status: Running", vga_color(VGA_COLOR_GREEN, VGA_COLOR_LIGHT_GREY));
-    vga_set_cursor(47, 17);
-    vga_print("Memory: 32MB", vga_color(VGA_COLOR_BLACK, VGA_COLOR_LIGHT_GREY));
-    
-    // Main desktop loop
+    draw_list_text(info, 2, 2, "Version: 0.1.0", vga_color(VGA_COLOR_BLACK, VGA_COLOR_LIGHT_GREY));
+    // BOOT_INFO (and the memory map) only comes from the UEFI loader
+    draw_list_text(info, 2, 3, boot_info ? "Boot: UEFI" : "Boot: BIOS/MBR",
+                   vga_color(VGA_COLOR_BLACK, VGA_COLOR_LIGHT_GREY));
+    draw_list_text(info, 2, 4, "Status: Running", vga_color(VGA_COLOR_GREEN, VGA_COLOR_LIGHT_GREY));
+    draw_list_text(info, 2, 5,
+                   boot_info ? desktop_memory_text(boot_info->Memory.TotalMemoryMB) : "Memory: unknown",
+                   vga_color(VGA_COLOR_BLACK, VGA_COLOR_LIGHT_GREY));
+    
+    compositor_render();
+    
+    // Main desktop loop: poll input every pass, tick the clock every
+    // DESKTOP_CLOCK_FRAMES passes
+    int frame = 0;
     while (1) {
-        desktop_update();
+        ps2_poll();
+        desktop_handle_input();
         
-        // Simple delay
-        for (volatile int i = 0; i < 10000000; i++);
+        if (++frame >= DESKTOP_CLOCK_FRAMES) {
+            frame = 0;
+            desktop_update();
+        }
+        compositor_render();
         
-        asm volatile ("hlt");
+        // Simple delay (interrupts stay off, so no hlt here)
+        for (volatile int i = 0; i < 10000; i++);
     }
 }
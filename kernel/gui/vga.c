@@ -3,9 +3,7 @@
 
 #include "../kernel.h"
 
-// VGA text mode constants
-#define VGA_WIDTH 80
-#define VGA_HEIGHT 25
+// VGA text mode buffer
 #define VGA_MEMORY 0xB8000
 
 // VGA colors
@@ -30,6 +28,73 @@ static char* vga_buffer = (char*)VGA_MEMORY;
 static int cursor_x = 0;
 static int cursor_y = 0;
 
+// Framebuffer console (UEFI boot has no VGA text mode)
+// Cells are kept in a shadow buffer and drawn with the 8x8 font,
+// rows doubled to keep the 8x16 VGA cell shape
+#define FB_CELL_WIDTH 8
+#define FB_CELL_HEIGHT 16
+
+static char vga_shadow[VGA_WIDTH * VGA_HEIGHT * 2];
+static GRAPHICS_INFO* fb_info = NULL;
+static UINT32 fb_scale = 1;
+static UINT32 fb_origin_x = 0;
+static UINT32 fb_origin_y = 0;
+
+// Standard VGA palette (0xRRGGBB)
+static const UINT32 vga_palette[16] = {
+    0x000000, 0x0000AA, 0x00AA00, 0x00AAAA, 0xAA0000, 0xAA00AA, 0xAA5500, 0xAAAAAA,
+    0x555555, 0x5555FF, 0x55FF55, 0x55FFFF, 0xFF5555, 0xFF55FF, 0xFFFF55, 0xFFFFFF
+};
+
+// Draw one text cell on the framebuffer
+static void fb_draw_cell(char c, unsigned char color, int x, int y) {
+    UINT32 fg = vga_palette[color & 0x0F];
+    UINT32 bg = vga_palette[(color >> 4) & 0x0F];
+    unsigned char ch = (unsigned char)c;
+    if (ch < FONT8X8_FIRST_CHAR || ch > FONT8X8_LAST_CHAR) {
+        ch = ' ';
+    }
+    const unsigned char* glyph = font8x8_basic[ch - FONT8X8_FIRST_CHAR];
+
+    UINT32 pitch = fb_info->PixelsPerScanLine;
+    UINT32* row = (UINT32*)(UINTN)fb_info->FrameBufferBase
+                + (UINTN)(fb_origin_y + y * FB_CELL_HEIGHT * fb_scale) * pitch
+                + fb_origin_x + x * FB_CELL_WIDTH * fb_scale;
+
+    for (UINT32 py = 0; py < FB_CELL_HEIGHT * fb_scale; py++) {
+        unsigned char bits = glyph[py / (2 * fb_scale)];
+        for (UINT32 px = 0; px < FB_CELL_WIDTH * fb_scale; px++) {
+            row[px] = ((bits >> (px / fb_scale)) & 1) ? fg : bg;
+        }
+        row += pitch;
+    }
+}
+
+// Switch text output to a linear framebuffer (32bpp, from BOOT_INFO)
+void vga_use_framebuffer(GRAPHICS_INFO* graphics) {
+    UINT32 scale_x = graphics->HorizontalResolution / (VGA_WIDTH * FB_CELL_WIDTH);
+    UINT32 scale_y = graphics->VerticalResolution / (VGA_HEIGHT * FB_CELL_HEIGHT);
+    UINT32 scale = (scale_x < scale_y) ? scale_x : scale_y;
+    if (scale == 0) {
+        return;  // Below 640x400, the text grid does not fit
+    }
+
+    fb_info = graphics;
+    fb_scale = scale;
+    fb_origin_x = (graphics->HorizontalResolution - VGA_WIDTH * FB_CELL_WIDTH * scale) / 2;
+    fb_origin_y = (graphics->VerticalResolution - VGA_HEIGHT * FB_CELL_HEIGHT * scale) / 2;
+    vga_buffer = vga_shadow;
+
+    // Clear borders around the text grid
+    UINT32* row = (UINT32*)(UINTN)graphics->FrameBufferBase;
+    for (UINT32 y = 0; y < graphics->VerticalResolution; y++) {
+        for (UINT32 x = 0; x < graphics->HorizontalResolution; x++) {
+            row[x] = vga_palette[VGA_COLOR_BLACK];
+        }
+        row += graphics->PixelsPerScanLine;
+    }
+}
+
 // Make VGA color byte
 unsigned char vga_color(unsigned char fg, unsigned char bg) {
     return fg | bg << 4;
@@ -40,6 +105,9 @@ void vga_clear_screen(unsigned char color) {
     for (int i = 0; i < VGA_WIDTH * VGA_HEIGHT; i++) {
         vga_buffer[i * 2] = ' ';
         vga_buffer[i * 2 + 1] = color;
+        if (fb_info) {
+            fb_draw_cell(' ', color, i % VGA_WIDTH, i / VGA_WIDTH);
+        }
     }
     cursor_x = 0;
     cursor_y = 0;
@@ -51,6 +119,9 @@ void vga_put_char_at(char c, unsigned char color, int x, int y) {
         int index = y * VGA_WIDTH + x;
         vga_buffer[index * 2] = c;
         vga_buffer[index * 2 + 1] = color;
+        if (fb_info) {
+            fb_draw_cell(c, color, x, y);
+        }
     }
 }
 
@@ -105,6 +105,20 @@ typedef struct {
     UINT32  TotalMemoryMB;    // Total memory in MB
 } BOOTLOADER_MEMORY_INFO;
 
+// Kernel image placement (must match kernel.ld)
+#define KERNEL_LOAD_ADDRESS  0x100000   // Link address - 1MB
+#define KERNEL_RESERVED_SIZE 0x100000   // Image, BSS and stack reserved by the UEFI loader
+#define KERNEL_STACK_SIZE    0x4000     // 16KB stack
+
+// Header at the start of kernel.bin (see entry.asm)
+#define KERNEL_IMAGE_MAGIC 0x534F444153555243ULL  // "CRUSADOS"
+
+typedef struct {
+    UINT64  Jump;       // Short jump over the header
+    UINT64  Magic;      // KERNEL_IMAGE_MAGIC
+    UINT64  ImageEnd;   // End of image, BSS and stack (_stack_top)
+} KERNEL_IMAGE_HEADER;
+
 // Kernel information structure
 typedef struct {
     UINT64  BaseAddress;
@@ -180,7 +194,7 @@ typedef struct {
 // Function prototypes
 
 // Core kernel functions
-void kernel_main(void);  // BIOS boot entry point
+void kernel_main(BOOT_INFO *BootInfo);  // NULL on BIOS boot, filled by the UEFI loader
 VOID ShowBootSplash(GRAPHICS_INFO *GraphicsInfo);
 VOID StartDesktop(VOID);
 VOID KernelPanic(CHAR16 *Message);
@@ -282,6 +296,16 @@ extern void vga_draw_hline(int x, int y, int width, char c, unsigned char color)
 extern void vga_draw_vline(int x, int y, int height, char c, unsigned char color);
 extern void vga_draw_rect(int x, int y, int width, int height, char c, unsigned char color);
 extern void vga_set_cursor(int x, int y);
+extern void vga_use_framebuffer(GRAPHICS_INFO* graphics);
+
+// 8x8 bitmap font for printable ASCII (0x20-0x7E), bit 0 is the leftmost pixel
+#define FONT8X8_FIRST_CHAR 0x20
+#define FONT8X8_LAST_CHAR  0x7E
+extern const unsigned char font8x8_basic[FONT8X8_LAST_CHAR - FONT8X8_FIRST_CHAR + 1][8];
+
+// VGA text mode dimensions
+#define VGA_WIDTH 80
+#define VGA_HEIGHT 25
 
 // VGA Colors for simple graphics
 #define VGA_COLOR_BLACK 0
@@ -300,15 +324,44 @@ extern void vga_set_cursor(int x, int y);
 #define VGA_COLOR_LIGHT_MAGENTA 13
 #define VGA_COLOR_LIGHT_BROWN 14
 #define VGA_COLOR_WHITE 15
+#define VGA_COLOR_YELLOW VGA_COLOR_LIGHT_BROWN
+
+// PS/2 Input Functions (polled, interrupts stay disabled)
+extern void ps2_init(void);
+extern void ps2_poll(void);
+extern char ps2_read_key(void);
+extern const MOUSE_STATE* ps2_mouse_state(void);
 
 // Boot Screen Functions
-extern void boot_screen_run(void);
+extern void boot_screen_run(BOOT_INFO* boot_info);
+
+// Compositor / Draw Command List Functions
+// Windows record commands (window-relative, clipped to the window) into their
+// own list; compositor_render() recomposites the area damaged by list or
+// window changes since the last frame. Windows must paint their whole area.
+// Text and blit sources must stay valid until the list is reset.
+#define COMPOSITOR_MAX_WINDOWS 16
+#define DRAW_LIST_MAX_COMMANDS 64
+#define COMPOSITOR_MAX_FRAME_COMMANDS (COMPOSITOR_MAX_WINDOWS * DRAW_LIST_MAX_COMMANDS)
+
+typedef struct draw_list draw_list_t;
+
+extern draw_list_t* compositor_create_window(int x, int y, int width, int height, int z);
+extern void compositor_destroy_window(draw_list_t* list);
+extern void compositor_set_visible(draw_list_t* list, BOOLEAN visible);
+extern void compositor_move_window(draw_list_t* list, int x, int y);
+extern void compositor_render(void);
+extern void draw_list_reset(draw_list_t* list);
+extern void draw_list_fill(draw_list_t* list, int x, int y, int width, int height, char c, unsigned char color);
+extern void draw_list_rect(draw_list_t* list, int x, int y, int width, int height, char c, unsigned char color);
+extern void draw_list_text(draw_list_t* list, int x, int y, const char* text, unsigned char color);
+extern void draw_list_blit(draw_list_t* list, int x, int y, int width, int height, const unsigned short* cells);
 
 // Desktop GUI Functions
 extern void desktop_init(void);
 extern void desktop_show_icons(void);
 extern void desktop_update(void);
-extern void desktop_run(void);
-extern void desktop_draw_window(int x, int y, int width, int height, const char* title);
+extern void desktop_run(BOOT_INFO* boot_info);
+extern draw_list_t* desktop_draw_window(int x, int y, int width, int height, const char* title);
 
 #endif // KERNEL_H
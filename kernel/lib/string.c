@@ -0,0 +1,65 @@
+// CrusadeOS Memory Routines - Freestanding string/memory helpers
+// GCC may emit calls to memcpy/memset/memmove/memcmp even with -ffreestanding,
+// so the kernel provides them. Marked used so LTO keeps them for late libcalls.
+
+#include "../kernel.h"
+
+#define KERNEL_LIBCALL __attribute__((used))
+
+// Copy memory (regions must not overlap)
+KERNEL_LIBCALL void* memcpy(void* dest, const void* src, __SIZE_TYPE__ n) {
+    void* ret = dest;
+    asm volatile ("rep movsb"
+                  : "+D"(dest), "+S"(src), "+c"(n)
+                  :
+                  : "memory");
+    return ret;
+}
+
+// Fill memory with a byte value
+KERNEL_LIBCALL void* memset(void* dest, int value, __SIZE_TYPE__ n) {
+    void* ret = dest;
+    asm volatile ("rep stosb"
+                  : "+D"(dest), "+c"(n)
+                  : "a"(value)
+                  : "memory");
+    return ret;
+}
+
+// Copy memory (regions may overlap)
+KERNEL_LIBCALL void* memmove(void* dest, const void* src, __SIZE_TYPE__ n) {
+    if (dest <= src || (const UINT8*)dest >= (const UINT8*)src + n) {
+        return memcpy(dest, src, n);
+    }
+
+    // Overlapping with dest above src: copy backwards
+    void* ret = dest;
+    UINT8* d = (UINT8*)dest + n - 1;
+    const UINT8* s = (const UINT8*)src + n - 1;
+    asm volatile ("std\n\trep movsb\n\tcld"
+                  : "+D"(d), "+S"(s), "+c"(n)
+                  :
+                  : "memory");
+    return ret;
+}
+
+// Compare memory
+KERNEL_LIBCALL int memcmp(const void* a, const void* b, __SIZE_TYPE__ n) {
+    const UINT8* pa = (const UINT8*)a;
+    const UINT8* pb = (const UINT8*)b;
+    for (__SIZE_TYPE__ i = 0; i < n; i++) {
+        if (pa[i] != pb[i]) {
+            return pa[i] - pb[i];
+        }
+    }
+    return 0;
+}
+
+// Kernel-style wrappers declared in kernel.h
+VOID MemoryCopy(VOID *Destination, VOID *Source, UINTN Length) {
+    memcpy(Destination, Source, Length);
+}
+
+VOID MemorySet(VOID *Buffer, UINT8 Value, UINTN Length) {
+    memset(Buffer, Value, Length);
+}
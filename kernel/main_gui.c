@@ -1,4 +1,4 @@
-// CrusadeOS Main Kernel - BIOS Boot with GUI
+// CrusadeOS Main Kernel - BIOS/UEFI Boot with GUI
 // Entry point that shows boot screen then desktop
 
 #include "kernel.h"
@@ -9,12 +9,20 @@ void kernel_print(const char* str) {
 }
 
 // Main kernel entry point
-void kernel_main(void) {
+void kernel_main(BOOT_INFO *BootInfo) {
+    // UEFI boot: no VGA text mode, draw text on the GOP framebuffer
+    if (BootInfo != NULL && BootInfo->Graphics.FrameBufferBase != 0) {
+        vga_use_framebuffer(&BootInfo->Graphics);
+    }
+    
+    // Initialize PS/2 keyboard and mouse
+    ps2_init();
+    
     // Show animated boot screen
-    boot_screen_run();
+    boot_screen_run(BootInfo);
     
     // Launch desktop environment
-    desktop_run();
+    desktop_run(BootInfo);
     
     // Should never reach here
     while (1) {
@@ -8,7 +8,7 @@ set -e
 BUILD_DIR="build"
 ISO_DIR="$BUILD_DIR/iso"
 BOOTLOADER="$BUILD_DIR/bootloader.efi"
-KERNEL="$BUILD_DIR/kernel.bin"
+KERNEL="$BUILD_DIR/crusadeos.bin"
 ISO_OUTPUT="$BUILD_DIR/proOS.iso"
 
 echo "=== Creating ProOS Bootable ISO ==="
@@ -30,18 +30,18 @@ fi
 echo "Creating ISO directory structure..."
 rm -rf "$ISO_DIR"
 mkdir -p "$ISO_DIR/EFI/BOOT"
-mkdir -p "$ISO_DIR/ProOS"
+mkdir -p "$ISO_DIR/CrusadeOS"
 
 # Copy files to ISO structure
 echo "Copying files..."
 cp "$BOOTLOADER" "$ISO_DIR/EFI/BOOT/BOOTX64.EFI"
-cp "$KERNEL" "$ISO_DIR/ProOS/kernel.bin"
+cp "$KERNEL" "$ISO_DIR/CrusadeOS/kernel.bin"
 
 # Create boot configuration file
-cat > "$ISO_DIR/ProOS/boot.cfg" << EOF
+cat > "$ISO_DIR/CrusadeOS/boot.cfg" << EOF
 # ProOS Boot Configuration
 title=ProOS v0.1.0
-kernel=/ProOS/kernel.bin
+kernel=/CrusadeOS/kernel.bin
 options=
 EOF
 
@@ -91,8 +91,9 @@ if [ -n "$EFI_IMG" ]; then
     
     # Try to mount the FAT image
     if hdiutil attach "$EFI_IMG" -mountpoint "$EFI_MOUNT" >/dev/null 2>&1; then
-        # Copy EFI directory to the FAT image
+        # Copy loader and kernel to the FAT image (the loader reads the kernel from its own volume)
         cp -r "$ISO_DIR/EFI" "$EFI_MOUNT/"
+        cp -r "$ISO_DIR/CrusadeOS" "$EFI_MOUNT/"
         
         # Unmount EFI image
         hdiutil detach "$EFI_MOUNT" >/dev/null 2>&1